@@ -2,6 +2,67 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define HAVE_C11_THREADS 1
+#include <threads.h>
+#else
+#define HAVE_C11_THREADS 0
+#endif
+
+/* Build with -DWORD_STATS=0 to compile the counters out entirely.
+   Counters are kept per thread; get_sorted_words_array_from_files folds
+   the counts of its worker threads into the calling thread's totals. */
+#ifndef WORD_STATS
+#define WORD_STATS 1
+#endif
+
+struct word_stats {
+    long long bytes_scanned;
+    long long words_emitted;
+    long long comparisons;
+    long long allocations;
+};
+
+#if WORD_STATS
+#if HAVE_C11_THREADS
+static _Thread_local struct word_stats g_word_stats;
+#else
+static struct word_stats g_word_stats;
+#endif
+#define STATS_ADD(field, n) (g_word_stats.field += (n))
+#else
+#define STATS_ADD(field, n) ((void)(n))
+#endif
+
+int word_stats_enabled(void) {
+    return WORD_STATS;
+}
+
+void reset_word_stats(void) {
+#if WORD_STATS
+    memset(&g_word_stats, 0, sizeof(g_word_stats));
+#endif
+}
+
+void get_word_stats(struct word_stats* out) {
+    if (out == NULL) return;
+#if WORD_STATS
+    *out = g_word_stats;
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+void print_word_stats_json(FILE* out) {
+    struct word_stats stats;
+    get_word_stats(&stats);
+    if (out == NULL) out = stdout;
+
+    fprintf(out,
+        "{\"bytes_scanned\": %lld, \"words_emitted\": %lld, \"comparisons\": %lld, \"allocations\": %lld}\n",
+        stats.bytes_scanned, stats.words_emitted, stats.comparisons, stats.allocations);
+}
 
 char* read_text_file(const char* filename) {
     if (filename == NULL) {
@@ -32,6 +93,7 @@ char* read_text_file(const char* filename) {
         printf("File '%s' is empty\n", filename);
         fclose(file);
         char* empty_buffer = malloc(1);
+        STATS_ADD(allocations, 1);
         if (empty_buffer != NULL) {
             empty_buffer[0] = '\0';
         }
@@ -41,6 +103,7 @@ char* read_text_file(const char* filename) {
     rewind(file);
 
     char* buffer = (char*)malloc(file_size + 1);
+    STATS_ADD(allocations, 1);
     if (buffer == NULL) {
         printf("Error: failed to allocate memory for file\n");
         fclose(file);
@@ -95,9 +158,12 @@ char** split_to_words(char* text, int* word_count) {
         }
     }
 
+    STATS_ADD(bytes_scanned, temp - text);
+
     if (*word_count == 0) return NULL;
 
     char** words = malloc(*word_count * sizeof(char*));
+    STATS_ADD(allocations, 1);
     if (words == NULL) {
         return NULL;
     }
@@ -114,6 +180,7 @@ char** split_to_words(char* text, int* word_count) {
 
             int len = text - start;
             words[i] = malloc(len + 1);
+            STATS_ADD(allocations, 1);
             if (words[i] == NULL) {
                 for (int j = 0; j < i; j++) free(words[j]);
                 free(words);
@@ -121,6 +188,7 @@ char** split_to_words(char* text, int* word_count) {
             }
             strncpy(words[i], start, len);
             words[i][len] = '\0';
+            STATS_ADD(words_emitted, 1);
             i++;
         }
         else {
@@ -134,6 +202,7 @@ char** split_to_words(char* text, int* word_count) {
 int compare_by_length_then_alpha(const void* a, const void* b) {
     const char* word1 = *(const char**)a;
     const char* word2 = *(const char**)b;
+    STATS_ADD(comparisons, 1);
 
     size_t len1 = strlen(word1);
     size_t len2 = strlen(word2);
@@ -170,6 +239,603 @@ char** get_sorted_words_array_from_file(const char* filename, int* word_count) {
     return words;
 }
 
+struct file_words {
+    char** words;
+    int count;
+    int pos;
+};
+
+struct file_worker {
+    const char* const* filenames;
+    struct file_words* results;
+    int file_count;
+    int first;
+    int step;
+    struct word_stats stats;
+};
+
+static int process_files(void* arg) {
+    struct file_worker* worker = (struct file_worker*)arg;
+    for (int i = worker->first; i < worker->file_count; i += worker->step) {
+        worker->results[i].words = get_sorted_words_array_from_file(worker->filenames[i],
+            &worker->results[i].count);
+        worker->results[i].pos = 0;
+    }
+    return 0;
+}
+
+#if HAVE_C11_THREADS
+/* Thread entry point: hands the thread's own counters back for merging after join. */
+static int process_files_thread(void* arg) {
+    struct file_worker* worker = (struct file_worker*)arg;
+    process_files(worker);
+#if WORD_STATS
+    worker->stats = g_word_stats;
+#endif
+    return 0;
+}
+#endif
+
+static void run_file_workers(const char* const* filenames, struct file_words* results,
+    int file_count, int thread_count) {
+    if (thread_count > file_count) thread_count = file_count;
+    if (thread_count < 1) thread_count = 1;
+
+#if HAVE_C11_THREADS
+    struct file_worker* workers = malloc(thread_count * sizeof(struct file_worker));
+    thrd_t* threads = malloc(thread_count * sizeof(thrd_t));
+    if (workers != NULL && threads != NULL) {
+        for (int t = 0; t < thread_count; t++) {
+            workers[t].filenames = filenames;
+            workers[t].results = results;
+            workers[t].file_count = file_count;
+            workers[t].first = t;
+            workers[t].step = thread_count;
+        }
+
+        int started = 1;
+        for (int t = 1; t < thread_count; t++) {
+            if (thrd_create(&threads[t], process_files_thread, &workers[t]) != thrd_success) break;
+            started++;
+        }
+
+        /* Worker 0 and any worker that failed to start run on the calling thread. */
+        for (int t = started; t < thread_count; t++) {
+            process_files(&workers[t]);
+        }
+        process_files(&workers[0]);
+
+        for (int t = 1; t < started; t++) {
+            thrd_join(threads[t], NULL);
+#if WORD_STATS
+            g_word_stats.bytes_scanned += workers[t].stats.bytes_scanned;
+            g_word_stats.words_emitted += workers[t].stats.words_emitted;
+            g_word_stats.comparisons += workers[t].stats.comparisons;
+            g_word_stats.allocations += workers[t].stats.allocations;
+#endif
+        }
+
+        free(workers);
+        free(threads);
+        return;
+    }
+    free(workers);
+    free(threads);
+#endif
+
+    struct file_worker worker = { filenames, results, file_count, 0, 1, { 0 } };
+    process_files(&worker);
+}
+
+static int merge_cursor_less(const struct file_words* a, const struct file_words* b) {
+    return compare_by_length_then_alpha(&a->words[a->pos], &b->words[b->pos]) < 0;
+}
+
+static void merge_sift_down(struct file_words** heap, int size, int i) {
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && merge_cursor_less(heap[left], heap[smallest])) smallest = left;
+        if (right < size && merge_cursor_less(heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) return;
+
+        struct file_words* tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+/* Tokenizes and sorts every file on up to thread_count workers, then k-way merges
+   the per-file results into one array ordered by compare_by_length_then_alpha.
+   With deduplicate set, each distinct word appears once. Unreadable files are skipped. */
+char** get_sorted_words_array_from_files(const char* const* filenames, int file_count,
+    int thread_count, int deduplicate, int* word_count) {
+    if (word_count == NULL) return NULL;
+
+    *word_count = 0;
+    if (filenames == NULL || file_count <= 0) return NULL;
+
+    struct file_words* results = calloc(file_count, sizeof(struct file_words));
+    struct file_words** heap = malloc(file_count * sizeof(struct file_words*));
+    STATS_ADD(allocations, 2);
+    if (results == NULL || heap == NULL) {
+        free(results);
+        free(heap);
+        return NULL;
+    }
+
+    run_file_workers(filenames, results, file_count, thread_count);
+
+    long long total = 0;
+    int size = 0;
+    for (int i = 0; i < file_count; i++) {
+        results[i].pos = 0;
+        if (results[i].words != NULL && results[i].count > 0) {
+            total += results[i].count;
+            heap[size++] = &results[i];
+        }
+    }
+
+    char** words = NULL;
+    if (total > INT_MAX) {
+        printf("Error: %lld words exceed the supported maximum of %d\n", total, INT_MAX);
+    }
+    else if (total > 0) {
+        words = malloc(total * sizeof(char*));
+        STATS_ADD(allocations, 1);
+    }
+
+    if (words == NULL) {
+        for (int i = 0; i < file_count; i++) {
+            for (int j = 0; j < results[i].count; j++) free(results[i].words[j]);
+            free(results[i].words);
+        }
+        free(results);
+        free(heap);
+        return NULL;
+    }
+
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        merge_sift_down(heap, size, i);
+    }
+
+    int count = 0;
+    while (size > 0) {
+        struct file_words* top = heap[0];
+        char* word = top->words[top->pos++];
+
+        if (deduplicate && count > 0 && strcmp(words[count - 1], word) == 0) {
+            free(word);
+        }
+        else {
+            words[count++] = word;
+        }
+
+        if (top->pos == top->count) {
+            heap[0] = heap[--size];
+        }
+        merge_sift_down(heap, size, 0);
+    }
+
+    for (int i = 0; i < file_count; i++) {
+        free(results[i].words);
+    }
+    free(results);
+    free(heap);
+
+    *word_count = count;
+    return words;
+}
+
+enum utf8_char_class {
+    CHAR_OTHER = 0,
+    CHAR_LETTER = 1,
+    CHAR_JOINER = 2
+};
+
+#define L CHAR_LETTER
+#define J CHAR_JOINER
+static const unsigned char ascii_char_class[128] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, J, 0, 0, 0, 0, 0, J, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L,
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, 0,
+    0, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L,
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, 0
+};
+#undef L
+#undef J
+
+/* Number of bytes in a sequence by its lead byte, 0 for bytes that cannot start one. */
+static const unsigned char utf8_sequence_length[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static int utf8_decode(const unsigned char* s, unsigned int* codepoint) {
+    int length = utf8_sequence_length[s[0]];
+    unsigned int cp;
+
+    switch (length) {
+    case 1: *codepoint = s[0]; return 1;
+    case 2: cp = s[0] & 0x1F; break;
+    case 3: cp = s[0] & 0x0F; break;
+    case 4: cp = s[0] & 0x07; break;
+    default: return 0;
+    }
+
+    for (int i = 1; i < length; i++) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+
+    if ((length == 3 && cp < 0x800) || (length == 4 && (cp < 0x10000 || cp > 0x10FFFF)) ||
+        (cp >= 0xD800 && cp <= 0xDFFF)) {
+        return 0;
+    }
+
+    *codepoint = cp;
+    return length;
+}
+
+/* Letters of the Latin, Greek and Cyrillic scripts. */
+int is_unicode_letter(unsigned int cp) {
+    if (cp < 0x80) return ascii_char_class[cp] == CHAR_LETTER;
+    if (cp == 0xAA || cp == 0xB5 || cp == 0xBA) return 1;
+    if (cp >= 0xC0 && cp <= 0x2AF) return cp != 0xD7 && cp != 0xF7;
+    if (cp >= 0x386 && cp <= 0x3FF) return cp != 0x387 && cp != 0x3F6;
+    if (cp >= 0x400 && cp <= 0x52F) return cp < 0x482 || cp > 0x489;
+    if (cp >= 0x1E00 && cp <= 0x1FFF) return 1;
+    return 0;
+}
+
+static int utf8_char_class(const unsigned char* s, int* size) {
+    if (s[0] < 0x80) {
+        *size = 1;
+        return ascii_char_class[s[0]];
+    }
+
+    unsigned int cp;
+    int length = utf8_decode(s, &cp);
+    if (length == 0) {
+        *size = 1;
+        return CHAR_OTHER;
+    }
+
+    *size = length;
+    if (is_unicode_letter(cp)) return CHAR_LETTER;
+    if ((cp >= 0x300 && cp <= 0x36F) || cp == 0x2019) return CHAR_JOINER;
+    return CHAR_OTHER;
+}
+
+/* Callers account for bytes_scanned, since split_to_words_utf8 scans the text twice. */
+static const char* next_word_utf8(const char* text, int* length) {
+    const unsigned char* p = (const unsigned char*)text;
+    int size;
+
+    while (*p && utf8_char_class(p, &size) != CHAR_LETTER) p += size;
+    if (*p == '\0') return NULL;
+
+    const unsigned char* end = p;
+    while (*end && utf8_char_class(end, &size) != CHAR_OTHER) end += size;
+
+    *length = (int)(end - p);
+    return (const char*)p;
+}
+
+/* Like split_to_words, but accepts UTF-8 letters. Invalid sequences act as separators. */
+char** split_to_words_utf8(const char* text, int* word_count) {
+    if (!text || !word_count) return NULL;
+
+    *word_count = 0;
+    if (text[0] == '\0') return NULL;
+
+    int length;
+    const char* start;
+    const char* temp = text;
+    while ((start = next_word_utf8(temp, &length)) != NULL) {
+        (*word_count)++;
+        temp = start + length;
+    }
+
+    STATS_ADD(bytes_scanned, (temp - text) + strlen(temp));
+
+    if (*word_count == 0) return NULL;
+
+    char** words = malloc(*word_count * sizeof(char*));
+    STATS_ADD(allocations, 1);
+    if (words == NULL) {
+        *word_count = 0;
+        return NULL;
+    }
+
+    int i = 0;
+    while ((start = next_word_utf8(text, &length)) != NULL) {
+        words[i] = malloc(length + 1);
+        STATS_ADD(allocations, 1);
+        if (words[i] == NULL) {
+            for (int j = 0; j < i; j++) free(words[j]);
+            free(words);
+            *word_count = 0;
+            return NULL;
+        }
+        memcpy(words[i], start, length);
+        words[i][length] = '\0';
+        STATS_ADD(words_emitted, 1);
+        text = start + length;
+        i++;
+    }
+
+    return words;
+}
+
+/* Length of a UTF-8 string in code points. */
+int utf8_length(const char* word) {
+    int length = 0;
+    for (const unsigned char* p = (const unsigned char*)word; *p; p++) {
+        if ((*p & 0xC0) != 0x80) length++;
+    }
+    return length;
+}
+
+/* Byte order of valid UTF-8 is code point order, so strcmp suffices for the tie-break. */
+int compare_by_utf8_length_then_codepoint(const void* a, const void* b) {
+    const char* word1 = *(const char**)a;
+    const char* word2 = *(const char**)b;
+    STATS_ADD(comparisons, 1);
+
+    int len1 = utf8_length(word1);
+    int len2 = utf8_length(word2);
+
+    if (len1 < len2) return -1;
+    if (len1 > len2) return 1;
+
+    return strcmp(word1, word2);
+}
+
+/* Uses the current LC_COLLATE locale for the tie-break. */
+int compare_by_utf8_length_then_collation(const void* a, const void* b) {
+    const char* word1 = *(const char**)a;
+    const char* word2 = *(const char**)b;
+    STATS_ADD(comparisons, 1);
+
+    int len1 = utf8_length(word1);
+    int len2 = utf8_length(word2);
+
+    if (len1 < len2) return -1;
+    if (len1 > len2) return 1;
+
+    return strcoll(word1, word2);
+}
+
+void sort_words_utf8(char** words, int word_count, int use_locale) {
+    if (words == NULL || word_count <= 1) return;
+    qsort(words, word_count, sizeof(char*),
+        use_locale ? compare_by_utf8_length_then_collation : compare_by_utf8_length_then_codepoint);
+}
+
+char** get_sorted_words_array_from_file_utf8(const char* filename, int* word_count, int use_locale) {
+    char* text = read_text_file(filename);
+    if (text == NULL) {
+        *word_count = 0;
+        return NULL;
+    }
+
+    char** words = split_to_words_utf8(text, word_count);
+    if (words == NULL) {
+        free(text);
+        *word_count = 0;
+        return NULL;
+    }
+
+    sort_words_utf8(words, *word_count, use_locale);
+
+    free(text);
+
+    return words;
+}
+
+struct word_ref {
+    const char* start;
+    int length;
+};
+
+static const char* next_word(const char* text, int* length) {
+    const char* begin = text;
+    while (*text && !is_latin_letter(*text)) text++;
+    if (*text == '\0') {
+        STATS_ADD(bytes_scanned, text - begin);
+        return NULL;
+    }
+
+    const char* end = text;
+    while (*end && (is_latin_letter(*end) || *end == '-' || *end == '\'')) end++;
+
+    STATS_ADD(bytes_scanned, end - begin);
+    *length = (int)(end - text);
+    return text;
+}
+
+static int compare_word_refs(const struct word_ref* a, const struct word_ref* b) {
+    STATS_ADD(comparisons, 1);
+    if (a->length < b->length) return -1;
+    if (a->length > b->length) return 1;
+    return memcmp(a->start, b->start, a->length);
+}
+
+static int compare_word_refs_qsort(const void* a, const void* b) {
+    return compare_word_refs((const struct word_ref*)a, (const struct word_ref*)b);
+}
+
+static void heap_sift_down(struct word_ref* heap, int size, int i) {
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && compare_word_refs(&heap[left], &heap[smallest]) < 0) smallest = left;
+        if (right < size && compare_word_refs(&heap[right], &heap[smallest]) < 0) smallest = right;
+        if (smallest == i) return;
+
+        struct word_ref tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void heap_sift_up(struct word_ref* heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (compare_word_refs(&heap[i], &heap[parent]) >= 0) return;
+
+        struct word_ref tmp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+/* Returns the k words that would end up last after sort_words, in the same
+   order, without materializing or sorting the whole word list. */
+char** top_k_longest_words(const char* text, int k, int* result_count) {
+    if (!text || !result_count) return NULL;
+
+    *result_count = 0;
+    if (k <= 0) return NULL;
+
+    /* The heap grows on demand up to k, so a huge k costs no more than the word count. */
+    int capacity = k < 16 ? k : 16;
+    struct word_ref* heap = malloc(capacity * sizeof(struct word_ref));
+    STATS_ADD(allocations, 1);
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    int size = 0;
+    int length;
+    const char* start;
+    while ((start = next_word(text, &length)) != NULL) {
+        struct word_ref candidate = { start, length };
+        if (size < k) {
+            if (size == capacity) {
+                int new_capacity = capacity > k / 2 ? k : capacity * 2;
+                struct word_ref* grown = realloc(heap, new_capacity * sizeof(struct word_ref));
+                STATS_ADD(allocations, 1);
+                if (grown == NULL) {
+                    free(heap);
+                    return NULL;
+                }
+                heap = grown;
+                capacity = new_capacity;
+            }
+            heap[size] = candidate;
+            heap_sift_up(heap, size);
+            size++;
+        }
+        else if (compare_word_refs(&candidate, &heap[0]) > 0) {
+            heap[0] = candidate;
+            heap_sift_down(heap, size, 0);
+        }
+        text = start + length;
+    }
+
+    if (size == 0) {
+        free(heap);
+        return NULL;
+    }
+
+    qsort(heap, size, sizeof(struct word_ref), compare_word_refs_qsort);
+
+    char** words = malloc(size * sizeof(char*));
+    STATS_ADD(allocations, 1);
+    if (words == NULL) {
+        free(heap);
+        return NULL;
+    }
+
+    for (int i = 0; i < size; i++) {
+        words[i] = malloc(heap[i].length + 1);
+        STATS_ADD(allocations, 1);
+        if (words[i] == NULL) {
+            for (int j = 0; j < i; j++) free(words[j]);
+            free(words);
+            free(heap);
+            return NULL;
+        }
+        memcpy(words[i], heap[i].start, heap[i].length);
+        words[i][heap[i].length] = '\0';
+        STATS_ADD(words_emitted, 1);
+    }
+
+    free(heap);
+    *result_count = size;
+    return words;
+}
+
+/* histogram[len] is the number of words of length len, for len in [0, *max_length]. */
+int* word_length_histogram(const char* text, int* max_length) {
+    if (!text || !max_length) return NULL;
+
+    *max_length = 0;
+    int capacity = 32;
+    int* histogram = calloc(capacity, sizeof(int));
+    STATS_ADD(allocations, 1);
+    if (histogram == NULL) {
+        return NULL;
+    }
+
+    int found = 0;
+    int length;
+    const char* start;
+    while ((start = next_word(text, &length)) != NULL) {
+        if (length >= capacity) {
+            int new_capacity = capacity;
+            while (length >= new_capacity) new_capacity *= 2;
+
+            int* grown = realloc(histogram, new_capacity * sizeof(int));
+            STATS_ADD(allocations, 1);
+            if (grown == NULL) {
+                free(histogram);
+                *max_length = 0;
+                return NULL;
+            }
+            memset(grown + capacity, 0, (new_capacity - capacity) * sizeof(int));
+            histogram = grown;
+            capacity = new_capacity;
+        }
+
+        histogram[length]++;
+        if (length > *max_length) *max_length = length;
+        found = 1;
+        text = start + length;
+    }
+
+    if (!found) {
+        free(histogram);
+        return NULL;
+    }
+
+    return histogram;
+}
+
 void print_words_longer_than(char** words, int word_count, int min_length) {
     if (words == NULL || word_count == 0) {
         printf("No words to display\n");
@@ -185,8 +851,9 @@ void print_words_longer_than(char** words, int word_count, int min_length) {
     int found = 0;
 
     for (int i = 0; i < word_count; i++) {
-        if (strlen(words[i]) > min_length) {
-            printf("%d: '%s' (length: %zu)\n", ++found, words[i], strlen(words[i]));
+        int length = utf8_length(words[i]);
+        if (length > min_length) {
+            printf("%d: '%s' (length: %d)\n", ++found, words[i], length);
         }
     }
 
@@ -213,7 +880,7 @@ void print_words_with_exact_length(char** words, int word_count, int exact_lengt
     int found = 0;
 
     for (int i = 0; i < word_count; i++) {
-        if (strlen(words[i]) == exact_length) {
+        if (utf8_length(words[i]) == exact_length) {
             printf("%d: '%s'\n", ++found, words[i]);
         }
     }
@@ -226,6 +893,307 @@ void print_words_with_exact_length(char** words, int word_count, int exact_lengt
     }
 }
 
+/* Deduplicated words kept as one packed trie per word length in code points.
+   Nodes are numbered breadth-first, so the children of a node occupy the id
+   range [first_child, first_child + child_count) in byte order. Each node
+   costs 7 bytes spread over four exactly sized arrays, and enumeration yields
+   words in compare_by_utf8_length_then_codepoint order (on ASCII that is
+   compare_by_length_then_alpha order) without storing the words themselves. */
+struct trie {
+    int* first_child;
+    unsigned char* child_count;
+    unsigned char* symbols;
+    unsigned char* terminal;
+    int node_count;
+    int word_count;
+};
+
+struct word_index {
+    struct trie* buckets;
+    int max_length;
+    int max_bytes;
+    int word_count;
+};
+
+typedef void (*word_visitor)(const char* word, void* ctx);
+
+static void free_trie(struct trie* trie) {
+    free(trie->first_child);
+    free(trie->child_count);
+    free(trie->symbols);
+    free(trie->terminal);
+}
+
+/* Builds the trie of count distinct words sorted by bytes; bytes[i] is strlen(words[i]).
+   Returns 0 on allocation failure. */
+static int build_trie(struct trie* trie, char** words, const int* bytes, int count) {
+    /* Each word adds one node per byte past its common prefix with the previous word. */
+    int node_count = 1 + bytes[0];
+    for (int i = 1; i < count; i++) {
+        int lcp = 0;
+        while (lcp < bytes[i] && lcp < bytes[i - 1] && words[i][lcp] == words[i - 1][lcp]) lcp++;
+        node_count += bytes[i] - lcp;
+    }
+
+    trie->first_child = malloc(node_count * sizeof(int));
+    trie->child_count = malloc(node_count);
+    trie->symbols = malloc(node_count);
+    trie->terminal = malloc(node_count);
+    int* ranges = malloc(3 * (size_t)node_count * sizeof(int));
+    STATS_ADD(allocations, 5);
+    if (trie->first_child == NULL || trie->child_count == NULL || trie->symbols == NULL ||
+        trie->terminal == NULL || ranges == NULL) {
+        free_trie(trie);
+        free(ranges);
+        return 0;
+    }
+
+    /* ranges holds, per node, the [lo, hi) slice of words below it and its depth. */
+    trie->symbols[0] = '\0';
+    ranges[0] = 0;
+    ranges[1] = count;
+    ranges[2] = 0;
+    int next = 1;
+
+    for (int node = 0; node < node_count; node++) {
+        int lo = ranges[3 * node];
+        int hi = ranges[3 * node + 1];
+        int depth = ranges[3 * node + 2];
+
+        /* A word equal to the shared prefix sorts first in its slice. */
+        trie->terminal[node] = bytes[lo] == depth;
+        trie->first_child[node] = next;
+        trie->child_count[node] = 0;
+
+        int i = lo + trie->terminal[node];
+        while (i < hi) {
+            unsigned char symbol = (unsigned char)words[i][depth];
+            int j = i + 1;
+            while (j < hi && (unsigned char)words[j][depth] == symbol) j++;
+
+            trie->symbols[next] = symbol;
+            ranges[3 * next] = i;
+            ranges[3 * next + 1] = j;
+            ranges[3 * next + 2] = depth + 1;
+            next++;
+            trie->child_count[node]++;
+            i = j;
+        }
+    }
+
+    free(ranges);
+    trie->node_count = node_count;
+    trie->word_count = count;
+    return 1;
+}
+
+void free_word_index(struct word_index* index) {
+    if (index == NULL) return;
+    for (int len = 0; len <= index->max_length; len++) {
+        free_trie(&index->buckets[len]);
+    }
+    free(index->buckets);
+    free(index);
+}
+
+struct word_index* build_word_index(char** words, int word_count) {
+    if (words == NULL || word_count <= 0) return NULL;
+
+    char** sorted = malloc(word_count * sizeof(char*));
+    int* bytes = malloc(word_count * sizeof(int));
+    int* lengths = malloc(word_count * sizeof(int));
+    STATS_ADD(allocations, 3);
+    if (sorted == NULL || bytes == NULL || lengths == NULL) {
+        free(sorted);
+        free(bytes);
+        free(lengths);
+        return NULL;
+    }
+
+    memcpy(sorted, words, word_count * sizeof(char*));
+    qsort(sorted, word_count, sizeof(char*), compare_by_utf8_length_then_codepoint);
+
+    int unique = 0;
+    for (int i = 0; i < word_count; i++) {
+        if (sorted[i][0] == '\0') continue;
+        if (unique > 0 && strcmp(sorted[unique - 1], sorted[i]) == 0) continue;
+        sorted[unique] = sorted[i];
+        bytes[unique] = (int)strlen(sorted[i]);
+        lengths[unique] = utf8_length(sorted[i]);
+        unique++;
+    }
+
+    struct word_index* index = NULL;
+    if (unique > 0) {
+        index = malloc(sizeof(struct word_index));
+        STATS_ADD(allocations, 1);
+    }
+    if (index != NULL) {
+        index->max_length = lengths[unique - 1];
+        index->max_bytes = 0;
+        index->word_count = unique;
+        index->buckets = calloc(index->max_length + 1, sizeof(struct trie));
+        STATS_ADD(allocations, 1);
+        if (index->buckets == NULL) {
+            free(index);
+            index = NULL;
+        }
+    }
+
+    for (int i = 0; index != NULL && i < unique; ) {
+        int j = i;
+        while (j < unique && lengths[j] == lengths[i]) {
+            if (bytes[j] > index->max_bytes) index->max_bytes = bytes[j];
+            j++;
+        }
+
+        if (!build_trie(&index->buckets[lengths[i]], sorted + i, bytes + i, j - i)) {
+            free_word_index(index);
+            index = NULL;
+        }
+        i = j;
+    }
+
+    free(sorted);
+    free(bytes);
+    free(lengths);
+    return index;
+}
+
+/* Walks the subtree of node, whose word prefix fills buffer[0..depth). The
+   pattern is consumed one code point at a time: a literal must match byte for
+   byte, '?' takes any one code point (pending counts its continuation bytes),
+   and once the pattern is exhausted the rest of the subtree matches. */
+static int trie_collect(const struct trie* trie, int node, int depth, const char* pattern,
+    int pending, char* buffer, word_visitor visit, void* ctx) {
+    int found = 0;
+    if (pending == 0 && *pattern == '\0' && trie->terminal[node]) {
+        buffer[depth] = '\0';
+        if (visit != NULL) visit(buffer, ctx);
+        found++;
+    }
+
+    int first = trie->first_child[node];
+    int last = first + trie->child_count[node];
+
+    if (pending == 0 && *pattern != '\0' && *pattern != '?') {
+        unsigned char wanted = (unsigned char)*pattern;
+        int lo = first;
+        int hi = last;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (trie->symbols[mid] < wanted) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < last && trie->symbols[lo] == wanted) {
+            buffer[depth] = (char)wanted;
+            found += trie_collect(trie, lo, depth + 1, pattern + 1, 0, buffer, visit, ctx);
+        }
+        return found;
+    }
+
+    for (int child = first; child < last; child++) {
+        unsigned char symbol = trie->symbols[child];
+        const char* next_pattern = pattern;
+        int next_pending = 0;
+
+        if (pending > 0) {
+            next_pending = pending - 1;
+        }
+        else if (*pattern == '?') {
+            int length = utf8_sequence_length[symbol];
+            next_pending = length > 1 ? length - 1 : 0;
+            next_pattern = pattern + 1;
+        }
+
+        buffer[depth] = (char)symbol;
+        found += trie_collect(trie, child, depth + 1, next_pattern, next_pending, buffer, visit, ctx);
+    }
+
+    return found;
+}
+
+static int word_index_lookup(const struct word_index* index, const char* pattern,
+    int min_length, int max_length, word_visitor visit, void* ctx) {
+    if (index == NULL || pattern == NULL) return 0;
+    if (max_length > index->max_length) max_length = index->max_length;
+    if (min_length < 1) min_length = 1;
+    if (min_length > max_length) return 0;
+
+    char* buffer = malloc(index->max_bytes + 1);
+    STATS_ADD(allocations, 1);
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    int found = 0;
+    for (int len = min_length; len <= max_length; len++) {
+        const struct trie* trie = &index->buckets[len];
+        if (trie->word_count == 0) continue;
+        found += trie_collect(trie, 0, 0, pattern, 0, buffer, visit, ctx);
+    }
+
+    free(buffer);
+    return found;
+}
+
+/* Calls visit for every indexed word starting with prefix, in sorted order, and
+   returns the number of matches. '?' matches any one code point (one character
+   of ASCII text, but the whole multi-byte sequence of a UTF-8 letter), and
+   lengths are counted in code points. visit may be NULL. */
+int find_words_with_prefix(const struct word_index* index, const char* prefix, word_visitor visit, void* ctx) {
+    if (prefix == NULL) return 0;
+    return word_index_lookup(index, prefix, utf8_length(prefix), INT_MAX, visit, ctx);
+}
+
+/* Like find_words_with_prefix, but only words exactly as long as the pattern match. */
+int find_words_matching(const struct word_index* index, const char* pattern, word_visitor visit, void* ctx) {
+    if (pattern == NULL) return 0;
+    int length = utf8_length(pattern);
+    return word_index_lookup(index, pattern, length, length, visit, ctx);
+}
+
+static void print_indexed_word(const char* word, void* ctx) {
+    int* found = (int*)ctx;
+    printf("%d: '%s'\n", ++(*found), word);
+}
+
+void print_words_with_prefix(const struct word_index* index, const char* prefix) {
+    if (index == NULL || prefix == NULL) {
+        printf("No words to display\n");
+        return;
+    }
+
+    printf("Words starting with '%s':\n", prefix);
+    int found = 0;
+    find_words_with_prefix(index, prefix, print_indexed_word, &found);
+
+    if (found == 0) {
+        printf("No words found starting with '%s'\n", prefix);
+    }
+    else {
+        printf("Total: %d words\n", found);
+    }
+}
+
+void print_words_matching(const struct word_index* index, const char* pattern) {
+    if (index == NULL || pattern == NULL) {
+        printf("No words to display\n");
+        return;
+    }
+
+    printf("Words matching '%s':\n", pattern);
+    int found = 0;
+    find_words_matching(index, pattern, print_indexed_word, &found);
+
+    if (found == 0) {
+        printf("No words found matching '%s'\n", pattern);
+    }
+    else {
+        printf("Total: %d words\n", found);
+    }
+}
+
 int original_main() {
     const char* filename = "text.txt";
     int word_count = 0;
@@ -1,5 +1,8 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <gtest/gtest.h>
+#include <climits>
+#include <string>
+#include <vector>
 
 extern "C" {
     int is_latin_letter(char c);
@@ -8,6 +11,37 @@ extern "C" {
     int compare_by_length_then_alpha(const void* a, const void* b);
     void print_words_longer_than(char** words, int word_count, int min_length);
     void print_words_with_exact_length(char** words, int word_count, int exact_length);
+
+    struct word_stats {
+        long long bytes_scanned;
+        long long words_emitted;
+        long long comparisons;
+        long long allocations;
+    };
+
+    int word_stats_enabled(void);
+    void reset_word_stats(void);
+    void get_word_stats(struct word_stats* out);
+    void print_word_stats_json(FILE* out);
+    void sort_words(char** words, int word_count);
+    char** top_k_longest_words(const char* text, int k, int* result_count);
+    int* word_length_histogram(const char* text, int* max_length);
+    int is_unicode_letter(unsigned int cp);
+    char** split_to_words_utf8(const char* text, int* word_count);
+    int utf8_length(const char* word);
+    int compare_by_utf8_length_then_codepoint(const void* a, const void* b);
+    void sort_words_utf8(char** words, int word_count, int use_locale);
+    char** get_sorted_words_array_from_files(const char* const* filenames, int file_count,
+        int thread_count, int deduplicate, int* word_count);
+
+    struct word_index;
+    typedef void (*word_visitor)(const char* word, void* ctx);
+    struct word_index* build_word_index(char** words, int word_count);
+    void free_word_index(struct word_index* index);
+    int find_words_with_prefix(const struct word_index* index, const char* prefix, word_visitor visit, void* ctx);
+    int find_words_matching(const struct word_index* index, const char* pattern, word_visitor visit, void* ctx);
+    void print_words_with_prefix(const struct word_index* index, const char* prefix);
+    void print_words_matching(const struct word_index* index, const char* pattern);
 }
 
 TEST(LatinLetter, ValidValue) {
@@ -225,6 +259,367 @@ TEST(PrintWordsTest, InvalidExactLength) {
     EXPECT_TRUE(output.find("Enter positive word length") != std::string::npos);
 }
 
+//top_k_longest_words tests
+
+TEST(TopKTest, InvalidInput) {
+    int count = -1;
+    EXPECT_EQ(top_k_longest_words(nullptr, 3, &count), nullptr);
+    EXPECT_EQ(top_k_longest_words("hello", 0, &count), nullptr);
+    EXPECT_EQ(count, 0);
+}
+
+TEST(TopKTest, MatchesTailOfSortedWords) {
+    int count = 0;
+    char** result = top_k_longest_words("dog elephant cat zebra giraffe apple", 3, &count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(count, 3);
+    EXPECT_STREQ(result[0], "zebra");
+    EXPECT_STREQ(result[1], "giraffe");
+    EXPECT_STREQ(result[2], "elephant");
+
+    for (int i = 0; i < count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(TopKTest, KLargerThanWordCount) {
+    int count = 0;
+    char** result = top_k_longest_words("bb a", 10, &count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(count, 2);
+    EXPECT_STREQ(result[0], "a");
+    EXPECT_STREQ(result[1], "bb");
+
+    for (int i = 0; i < count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(TopKTest, HugeKReturnsAllWords) {
+    int count = 0;
+    char** result = top_k_longest_words("one two three four five six seven eight nine ten eleven twelve "
+        "thirteen fourteen fifteen sixteen seventeen", INT_MAX, &count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(count, 17);
+    EXPECT_STREQ(result[0], "one");
+    EXPECT_STREQ(result[16], "seventeen");
+
+    for (int i = 0; i < count; i++) free(result[i]);
+    free(result);
+}
+
+//word_length_histogram tests
+
+TEST(HistogramTest, NoWords) {
+    int max_length = -1;
+    EXPECT_EQ(word_length_histogram("123 456", &max_length), nullptr);
+    EXPECT_EQ(max_length, 0);
+}
+
+TEST(HistogramTest, CountsLengths) {
+    int max_length = 0;
+    int* histogram = word_length_histogram("a bb cc it's supercalifragilisticexpialidocious", &max_length);
+
+    ASSERT_NE(histogram, nullptr);
+    EXPECT_EQ(max_length, 34);
+    EXPECT_EQ(histogram[1], 1);
+    EXPECT_EQ(histogram[2], 2);
+    EXPECT_EQ(histogram[3], 0);
+    EXPECT_EQ(histogram[4], 1);
+    EXPECT_EQ(histogram[34], 1);
+    free(histogram);
+}
+
+//utf8 tokenizer tests
+
+TEST(UnicodeLetter, ValidValue) {
+    EXPECT_TRUE(is_unicode_letter('a'));
+    EXPECT_TRUE(is_unicode_letter(0xE9));   // e acute
+    EXPECT_TRUE(is_unicode_letter(0x416));  // Cyrillic Zhe
+    EXPECT_TRUE(is_unicode_letter(0x3B1));  // Greek alpha
+    EXPECT_FALSE(is_unicode_letter(0xD7));  // multiplication sign
+    EXPECT_FALSE(is_unicode_letter('1'));
+    EXPECT_FALSE(is_unicode_letter(0x4E2D));
+}
+
+TEST(SplitToWordsUtf8Test, AsciiMatchesLatinTokenizer) {
+    int word_count = 0;
+    char** result = split_to_words_utf8("it's state-of-the-art hello123", &word_count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(word_count, 3);
+    EXPECT_STREQ(result[0], "it's");
+    EXPECT_STREQ(result[1], "state-of-the-art");
+    EXPECT_STREQ(result[2], "hello");
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(SplitToWordsUtf8Test, CyrillicAndAccentedWords) {
+    int word_count = 0;
+    char** result = split_to_words_utf8("\xD0\xBC\xD0\xB8\xD1\x80, caf\xC3\xA9!", &word_count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(word_count, 2);
+    EXPECT_STREQ(result[0], "\xD0\xBC\xD0\xB8\xD1\x80");
+    EXPECT_STREQ(result[1], "caf\xC3\xA9");
+    EXPECT_EQ(utf8_length(result[0]), 3);
+    EXPECT_EQ(utf8_length(result[1]), 4);
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(SplitToWordsUtf8Test, CountsEachByteOnce) {
+    if (!word_stats_enabled()) GTEST_SKIP();
+    reset_word_stats();
+
+    int word_count = 0;
+    char** result = split_to_words_utf8("bb a \xD0\xBC\xD0\xB8\xD1\x80 ", &word_count);
+    ASSERT_NE(result, nullptr);
+
+    struct word_stats stats;
+    get_word_stats(&stats);
+    EXPECT_EQ(stats.bytes_scanned, 12);
+    EXPECT_EQ(stats.words_emitted, 3);
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(SplitToWordsUtf8Test, InvalidBytesSeparateWords) {
+    int word_count = 0;
+    char** result = split_to_words_utf8("ab\xFF\xC3" "cd", &word_count);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(word_count, 2);
+    EXPECT_STREQ(result[0], "ab");
+    EXPECT_STREQ(result[1], "cd");
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(SortWordsUtf8Test, OrdersByCodePointLength) {
+    const char* words[] = { "abcd", "\xD0\xBC\xD0\xB8\xD1\x80", "ab" };
+    sort_words_utf8((char**)words, 3, 0);
+
+    EXPECT_STREQ(words[0], "ab");
+    EXPECT_STREQ(words[1], "\xD0\xBC\xD0\xB8\xD1\x80");
+    EXPECT_STREQ(words[2], "abcd");
+}
+
+//get_sorted_words_array_from_files tests
+
+static void write_test_file(const char* filename, const char* content) {
+    FILE* temp = fopen(filename, "w");
+    fprintf(temp, "%s", content);
+    fclose(temp);
+}
+
+TEST(MultiFileTest, InvalidInput) {
+    int word_count = -1;
+    EXPECT_EQ(get_sorted_words_array_from_files(nullptr, 2, 2, 0, &word_count), nullptr);
+    EXPECT_EQ(word_count, 0);
+}
+
+TEST(MultiFileTest, MergesSortedFiles) {
+    write_test_file("multi_a.txt", "pear fig apple");
+    write_test_file("multi_b.txt", "kiwi fig banana");
+    const char* filenames[] = { "multi_a.txt", "nonexistent.txt", "multi_b.txt" };
+
+    int word_count = 0;
+    char** result = get_sorted_words_array_from_files(filenames, 3, 2, 0, &word_count);
+
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(word_count, 6);
+    const char* expected[] = { "fig", "fig", "kiwi", "pear", "apple", "banana" };
+    for (int i = 0; i < word_count; i++) {
+        EXPECT_STREQ(result[i], expected[i]);
+        free(result[i]);
+    }
+    free(result);
+
+    remove("multi_a.txt");
+    remove("multi_b.txt");
+}
+
+TEST(MultiFileTest, MergesWorkerStats) {
+    if (!word_stats_enabled()) GTEST_SKIP();
+    write_test_file("stats_a.txt", "one two");
+    write_test_file("stats_b.txt", "three four five");
+    write_test_file("stats_c.txt", "six");
+    const char* filenames[] = { "stats_a.txt", "stats_b.txt", "stats_c.txt" };
+
+    reset_word_stats();
+    int word_count = 0;
+    char** result = get_sorted_words_array_from_files(filenames, 3, 3, 0, &word_count);
+    ASSERT_NE(result, nullptr);
+
+    struct word_stats stats;
+    get_word_stats(&stats);
+    EXPECT_EQ(stats.words_emitted, 6);
+    EXPECT_EQ(stats.bytes_scanned, 7 + 15 + 3);
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+
+    remove("stats_a.txt");
+    remove("stats_b.txt");
+    remove("stats_c.txt");
+}
+
+TEST(MultiFileTest, Deduplicates) {
+    write_test_file("dedup_a.txt", "fig apple fig");
+    write_test_file("dedup_b.txt", "apple fig");
+    const char* filenames[] = { "dedup_a.txt", "dedup_b.txt" };
+
+    int word_count = 0;
+    char** result = get_sorted_words_array_from_files(filenames, 2, 4, 1, &word_count);
+
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(word_count, 2);
+    EXPECT_STREQ(result[0], "fig");
+    EXPECT_STREQ(result[1], "apple");
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+
+    remove("dedup_a.txt");
+    remove("dedup_b.txt");
+}
+
+//word_index tests
+
+static void collect_word(const char* word, void* ctx) {
+    ((std::vector<std::string>*)ctx)->push_back(word);
+}
+
+TEST(WordIndexTest, NullInput) {
+    EXPECT_EQ(build_word_index(nullptr, 3), nullptr);
+    EXPECT_EQ(find_words_with_prefix(nullptr, "a", nullptr, nullptr), 0);
+}
+
+TEST(WordIndexTest, PrefixLookupIsSortedAndDeduplicated) {
+    const char* words[] = { "urban", "urb", "green", "urbane", "urban", "up" };
+    struct word_index* index = build_word_index((char**)words, 6);
+    ASSERT_NE(index, nullptr);
+
+    std::vector<std::string> found;
+    EXPECT_EQ(find_words_with_prefix(index, "urb", collect_word, &found), 3);
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(found[0], "urb");
+    EXPECT_EQ(found[1], "urban");
+    EXPECT_EQ(found[2], "urbane");
+
+    EXPECT_EQ(find_words_with_prefix(index, "x", nullptr, nullptr), 0);
+    EXPECT_EQ(find_words_with_prefix(index, "", nullptr, nullptr), 5);
+    free_word_index(index);
+}
+
+TEST(WordIndexTest, WildcardMatchesExactLength) {
+    const char* words[] = { "green", "groan", "grin", "given", "gory", "garden" };
+    struct word_index* index = build_word_index((char**)words, 6);
+    ASSERT_NE(index, nullptr);
+
+    std::vector<std::string> found;
+    EXPECT_EQ(find_words_matching(index, "g?r?n", collect_word, &found), 0);
+    EXPECT_EQ(find_words_matching(index, "g?r???", collect_word, &found), 1);
+    EXPECT_EQ(find_words_matching(index, "gr??n", collect_word, &found), 2);
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(found[0], "garden");
+    EXPECT_EQ(found[1], "green");
+    EXPECT_EQ(found[2], "groan");
+    free_word_index(index);
+}
+
+TEST(WordIndexTest, WildcardMatchesOneCodePoint) {
+    const char* words[] = { "\xD0\xBC\xD0\xB8\xD1\x80", "max", "mix", "\xD0\xBC\xD0\xB8\xD1\x80" };
+    struct word_index* index = build_word_index((char**)words, 4);
+    ASSERT_NE(index, nullptr);
+
+    std::vector<std::string> found;
+    EXPECT_EQ(find_words_matching(index, "\xD0\xBC?\xD1\x80", collect_word, &found), 1);
+    EXPECT_EQ(find_words_matching(index, "???", collect_word, &found), 3);
+    EXPECT_EQ(find_words_with_prefix(index, "\xD0\xBC", nullptr, nullptr), 1);
+    ASSERT_EQ(found.size(), 4u);
+    EXPECT_EQ(found[0], "\xD0\xBC\xD0\xB8\xD1\x80");
+    EXPECT_EQ(found[1], "max");
+    EXPECT_EQ(found[3], "\xD0\xBC\xD0\xB8\xD1\x80");
+    free_word_index(index);
+}
+
+TEST(WordIndexTest, PrintsMatches) {
+    const char* words[] = { "urban", "rural" };
+    struct word_index* index = build_word_index((char**)words, 2);
+
+    testing::internal::CaptureStdout();
+    print_words_with_prefix(index, "ur");
+    print_words_matching(index, "?????x");
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_TRUE(output.find("1: 'urban'") != std::string::npos);
+    EXPECT_TRUE(output.find("No words found matching '?????x'") != std::string::npos);
+    free_word_index(index);
+}
+
+TEST(PrintWordsTest, LengthQueriesCountCodePoints) {
+    const char* words[] = { "ab", "\xD0\xBC\xD0\xB8\xD1\x80", "abcd" };
+    testing::internal::CaptureStdout();
+    print_words_with_exact_length((char**)words, 3, 3);
+    print_words_longer_than((char**)words, 3, 2);
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_TRUE(output.find("1: '\xD0\xBC\xD0\xB8\xD1\x80'\n") != std::string::npos);
+    EXPECT_TRUE(output.find("'\xD0\xBC\xD0\xB8\xD1\x80' (length: 3)") != std::string::npos);
+    EXPECT_TRUE(output.find("(length: 4)") != std::string::npos);
+}
+
+//word_stats tests
+
+TEST(WordStatsTest, CountsTokenizerWork) {
+    if (!word_stats_enabled()) GTEST_SKIP();
+    reset_word_stats();
+
+    int word_count = 0;
+    char text[] = "bb a ccc";
+    char** result = split_to_words(text, &word_count);
+    ASSERT_NE(result, nullptr);
+    sort_words(result, word_count);
+
+    struct word_stats stats;
+    get_word_stats(&stats);
+    EXPECT_EQ(stats.bytes_scanned, 8);
+    EXPECT_EQ(stats.words_emitted, 3);
+    EXPECT_EQ(stats.allocations, 4);
+    EXPECT_GT(stats.comparisons, 0);
+
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+}
+
+TEST(WordStatsTest, ResetClearsCounters) {
+    int word_count = 0;
+    char text[] = "hello";
+    char** result = split_to_words(text, &word_count);
+    for (int i = 0; i < word_count; i++) free(result[i]);
+    free(result);
+
+    reset_word_stats();
+    struct word_stats stats;
+    get_word_stats(&stats);
+    EXPECT_EQ(stats.bytes_scanned, 0);
+    EXPECT_EQ(stats.words_emitted, 0);
+}
+
+TEST(WordStatsTest, PrintsJson) {
+    reset_word_stats();
+    testing::internal::CaptureStdout();
+    print_word_stats_json(stdout);
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_TRUE(output.find("\"words_emitted\": 0") != std::string::npos);
+}
+
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
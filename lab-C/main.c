@@ -1,8 +1,81 @@
 #define _CRT_SECURE_NO_WARNINGS
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/* Build with -DTRAVERSAL_STATS=0 to compile the counters out entirely. */
+#ifndef TRAVERSAL_STATS
+#define TRAVERSAL_STATS 1
+#endif
+
+struct traversal_stats {
+    long long queries;
+    long long vertices_visited;
+    long long edges_scanned;
+    int max_stack_depth;
+    double last_query_seconds;
+    double total_query_seconds;
+};
+
+/* Seconds on a clock that never steps backwards: QueryPerformanceCounter on
+   Windows, CLOCK_MONOTONIC on POSIX. Only when neither is usable does it fall
+   back to the realtime TIME_UTC clock, and then to process CPU time. */
+static double monotonic_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    if (QueryPerformanceFrequency(&frequency) && QueryPerformanceCounter(&counter)) {
+        return (double)counter.QuadPart / (double)frequency.QuadPart;
+    }
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0) {
+        return (double)now.tv_sec + now.tv_nsec / 1e9;
+    }
+#endif
+
+    struct timespec ts;
+    if (timespec_get(&ts, TIME_UTC) == TIME_UTC) {
+        return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+#if TRAVERSAL_STATS
+static struct traversal_stats g_traversal_stats;
+static int g_stack_depth = 0;
+
+static void stats_record_query(double started) {
+    double elapsed = monotonic_seconds() - started;
+    g_traversal_stats.queries++;
+    g_traversal_stats.last_query_seconds = elapsed;
+    g_traversal_stats.total_query_seconds += elapsed;
+}
+
+#define STATS_ADD(field, n) (g_traversal_stats.field += (n))
+#define STATS_QUERY_BEGIN() double stats_query_started = monotonic_seconds()
+#define STATS_QUERY_END() stats_record_query(stats_query_started)
+#define STATS_ENTER() \
+    do { \
+        if (++g_stack_depth > g_traversal_stats.max_stack_depth) \
+            g_traversal_stats.max_stack_depth = g_stack_depth; \
+    } while (0)
+#define STATS_LEAVE() (g_stack_depth--)
+#else
+#define STATS_ADD(field, n) ((void)0)
+#define STATS_QUERY_BEGIN() ((void)0)
+#define STATS_QUERY_END() ((void)0)
+#define STATS_ENTER() ((void)0)
+#define STATS_LEAVE() ((void)0)
+#endif
 
 struct node {
     int vertex;
@@ -90,34 +163,76 @@ struct graph* read_graph_from_file(const char* filename) {
     return graph;
 }
 
+int traversal_stats_enabled(void) {
+    return TRAVERSAL_STATS;
+}
+
+void reset_traversal_stats(void) {
+#if TRAVERSAL_STATS
+    memset(&g_traversal_stats, 0, sizeof(g_traversal_stats));
+    g_stack_depth = 0;
+#endif
+}
+
+void get_traversal_stats(struct traversal_stats* out) {
+    if (out == NULL) return;
+#if TRAVERSAL_STATS
+    *out = g_traversal_stats;
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+void print_traversal_stats_json(FILE* out) {
+    struct traversal_stats stats;
+    get_traversal_stats(&stats);
+    if (out == NULL) out = stdout;
+
+    fprintf(out,
+        "{\"queries\": %lld, \"vertices_visited\": %lld, \"edges_scanned\": %lld, "
+        "\"max_stack_depth\": %d, \"last_query_seconds\": %.6f, \"total_query_seconds\": %.6f}\n",
+        stats.queries, stats.vertices_visited, stats.edges_scanned,
+        stats.max_stack_depth, stats.last_query_seconds, stats.total_query_seconds);
+}
+
 bool dfs(struct graph* graph, int current, int target) {
     graph->visited[current] = true;
+    STATS_ADD(vertices_visited, 1);
+    STATS_ENTER();
 
     if (current == target) {
+        STATS_LEAVE();
         return true;
     }
 
     struct node* temp = graph->adj_lists[current];
     while (temp != NULL) {
         int adjacent_vertex = temp->vertex;
+        STATS_ADD(edges_scanned, 1);
         if (!graph->visited[adjacent_vertex]) {
             if (dfs(graph, adjacent_vertex, target)) {
+                STATS_LEAVE();
                 return true;
             }
         }
         temp = temp->next;
     }
+    STATS_LEAVE();
 
     return false;
 }
 
 bool path_exists(struct graph* graph, int start, int end) {
+    STATS_QUERY_BEGIN();
+
     for (int i = 0; i < graph->num_vertices; i++) {
         graph->visited[i] = false;
     }
 
     bool result = dfs(graph, start, end);
 
+    STATS_QUERY_END();
+
     for (int i = 0; i < graph->num_vertices; i++) {
         graph->visited[i] = false;
     }
@@ -139,6 +254,732 @@ void free_graph(struct graph* graph) {
     free(graph);
 }
 
+/* Adjacency lists stored as sorted neighbor ids, the first one as-is and the
+   rest as gaps from the previous id, each written as a little-endian base-128
+   varint. A typical edge costs 1-2 bytes instead of a heap-allocated node. */
+struct compressed_graph {
+    int num_vertices;
+    size_t* offsets;
+    int* degrees;
+    unsigned char* data;
+    size_t data_size;
+    size_t data_capacity;
+    bool* visited;
+    int* stack;
+};
+
+static size_t encode_varint(unsigned char* out, unsigned int value) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = (unsigned char)value;
+    return size;
+}
+
+static const unsigned char* decode_varint(const unsigned char* in, unsigned int* value) {
+    unsigned int result = *in & 0x7F;
+    int shift = 7;
+    while (*in++ & 0x80) {
+        result |= (unsigned int)(*in & 0x7F) << shift;
+        shift += 7;
+    }
+    *value = result;
+    return in;
+}
+
+static size_t varint_size(unsigned int value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+struct compressed_graph* create_compressed_graph(int vertices) {
+    struct compressed_graph* graph = malloc(sizeof(struct compressed_graph));
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    graph->num_vertices = vertices;
+    graph->offsets = calloc(vertices > 0 ? vertices : 1, sizeof(size_t));
+    graph->degrees = calloc(vertices > 0 ? vertices : 1, sizeof(int));
+    graph->visited = calloc(vertices > 0 ? vertices : 1, sizeof(bool));
+    graph->stack = malloc((vertices > 0 ? vertices : 1) * sizeof(int));
+    graph->data = NULL;
+    graph->data_size = 0;
+    graph->data_capacity = 0;
+
+    if (graph->offsets == NULL || graph->degrees == NULL || graph->visited == NULL || graph->stack == NULL) {
+        free(graph->offsets);
+        free(graph->degrees);
+        free(graph->visited);
+        free(graph->stack);
+        free(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+/* Returns the number of neighbors written to out, which must hold degrees[vertex] ints. */
+int get_compressed_neighbors(const struct compressed_graph* graph, int vertex, int* out) {
+    const unsigned char* p = graph->data + graph->offsets[vertex];
+    unsigned int gap;
+    int neighbor = 0;
+
+    for (int i = 0; i < graph->degrees[vertex]; i++) {
+        p = decode_varint(p, &gap);
+        neighbor += (int)gap;
+        out[i] = neighbor;
+    }
+
+    return graph->degrees[vertex];
+}
+
+/* Appends neighbors (which get sorted in place) to vertex's list. A vertex
+   listed twice has its old encoding merged in and left behind as dead bytes. */
+static bool set_compressed_neighbors(struct compressed_graph* graph, int vertex, int* neighbors, int count) {
+    int old_count = graph->degrees[vertex];
+    int total = old_count + count;
+    int* merged = neighbors;
+
+    if (old_count > 0) {
+        merged = malloc(total * sizeof(int));
+        if (merged == NULL) {
+            return false;
+        }
+        get_compressed_neighbors(graph, vertex, merged);
+        memcpy(merged + old_count, neighbors, count * sizeof(int));
+    }
+
+    qsort(merged, total, sizeof(int), compare_ints);
+
+    size_t needed = graph->data_size;
+    for (int i = 0; i < total; i++) {
+        needed += varint_size((unsigned int)(merged[i] - (i > 0 ? merged[i - 1] : 0)));
+    }
+    if (needed > graph->data_capacity) {
+        size_t capacity = graph->data_capacity > 0 ? graph->data_capacity : 64;
+        while (capacity < needed) capacity *= 2;
+
+        unsigned char* data = realloc(graph->data, capacity);
+        if (data == NULL) {
+            if (merged != neighbors) free(merged);
+            return false;
+        }
+        graph->data = data;
+        graph->data_capacity = capacity;
+    }
+
+    graph->offsets[vertex] = graph->data_size;
+    graph->degrees[vertex] = total;
+
+    int previous = 0;
+    for (int i = 0; i < total; i++) {
+        graph->data_size += encode_varint(graph->data + graph->data_size,
+            (unsigned int)(merged[i] - previous));
+        previous = merged[i];
+    }
+
+    if (merged != neighbors) free(merged);
+    return true;
+}
+
+/* Drops bytes orphaned by re-encoded lists and trims data to its final size.
+   Run once after loading, since set_compressed_neighbors over-allocates. */
+static bool finish_compressed_graph(struct compressed_graph* graph) {
+    if (graph->data == NULL) {
+        return true;
+    }
+
+    size_t live = 0;
+    for (int v = 0; v < graph->num_vertices; v++) {
+        const unsigned char* p = graph->data + graph->offsets[v];
+        for (int i = 0; i < graph->degrees[v]; i++) {
+            while (*p++ & 0x80) {}
+        }
+        live += (size_t)(p - (graph->data + graph->offsets[v]));
+    }
+
+    if (live == 0) {
+        free(graph->data);
+        graph->data = NULL;
+    }
+    else if (live < graph->data_size) {
+        unsigned char* data = malloc(live);
+        if (data == NULL) {
+            return false;
+        }
+
+        size_t size = 0;
+        for (int v = 0; v < graph->num_vertices; v++) {
+            const unsigned char* start = graph->data + graph->offsets[v];
+            const unsigned char* p = start;
+            for (int i = 0; i < graph->degrees[v]; i++) {
+                while (*p++ & 0x80) {}
+            }
+            memcpy(data + size, start, (size_t)(p - start));
+            graph->offsets[v] = size;
+            size += (size_t)(p - start);
+        }
+
+        free(graph->data);
+        graph->data = data;
+    }
+    else if (live < graph->data_capacity) {
+        unsigned char* data = realloc(graph->data, live);
+        if (data != NULL) {
+            graph->data = data;
+        }
+    }
+
+    graph->data_size = live;
+    graph->data_capacity = live;
+    return true;
+}
+
+void free_compressed_graph(struct compressed_graph* graph) {
+    if (graph == NULL) return;
+    free(graph->offsets);
+    free(graph->degrees);
+    free(graph->data);
+    free(graph->visited);
+    free(graph->stack);
+    free(graph);
+}
+
+struct compressed_graph* compress_graph(struct graph* source) {
+    if (source == NULL) return NULL;
+
+    struct compressed_graph* graph = create_compressed_graph(source->num_vertices);
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    int capacity = 16;
+    int* neighbors = malloc(capacity * sizeof(int));
+    if (neighbors == NULL) {
+        free_compressed_graph(graph);
+        return NULL;
+    }
+
+    for (int v = 0; v < source->num_vertices; v++) {
+        int count = 0;
+        for (struct node* temp = source->adj_lists[v]; temp != NULL; temp = temp->next) {
+            if (count == capacity) {
+                int* grown = realloc(neighbors, 2 * capacity * sizeof(int));
+                if (grown == NULL) {
+                    free(neighbors);
+                    free_compressed_graph(graph);
+                    return NULL;
+                }
+                neighbors = grown;
+                capacity *= 2;
+            }
+            neighbors[count++] = temp->vertex;
+        }
+
+        if (count > 0 && !set_compressed_neighbors(graph, v, neighbors, count)) {
+            free(neighbors);
+            free_compressed_graph(graph);
+            return NULL;
+        }
+    }
+
+    free(neighbors);
+    if (!finish_compressed_graph(graph)) {
+        free_compressed_graph(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+/* Same file format as read_graph_from_file, encoded as it is read so the
+   pointer-based lists are never built. Consecutive lines for the same vertex,
+   as needed for vertices whose ids do not fit on one line, are collected
+   before being encoded once. */
+struct compressed_graph* read_compressed_graph_from_file(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        printf("Error: cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    int num_vertices;
+    if (fscanf(file, "%d", &num_vertices) != 1) {
+        printf("Error: invalid file format\n");
+        fclose(file);
+        return NULL;
+    }
+
+    char buffer[256];
+    fgets(buffer, sizeof(buffer), file);
+
+    int capacity = 128;
+    int count = 0;
+    int pending_vertex = -1;
+    int* neighbors = malloc(capacity * sizeof(int));
+
+    struct compressed_graph* graph = create_compressed_graph(num_vertices);
+    if (graph == NULL || neighbors == NULL) {
+        free_compressed_graph(graph);
+        free(neighbors);
+        fclose(file);
+        return NULL;
+    }
+
+    bool ok = true;
+
+    for (int i = 0; i < num_vertices; i++) {
+        if (fgets(buffer, sizeof(buffer), file) == NULL) {
+            break;
+        }
+
+        char* colon_pos = strchr(buffer, ':');
+        if (colon_pos == NULL) {
+            continue;
+        }
+
+        int vertex = atoi(buffer);
+        if (vertex < 0 || vertex >= num_vertices) {
+            continue;
+        }
+
+        if (vertex != pending_vertex) {
+            if (count > 0 && !set_compressed_neighbors(graph, pending_vertex, neighbors, count)) {
+                ok = false;
+                break;
+            }
+            pending_vertex = vertex;
+            count = 0;
+        }
+
+        char* neighbors_str = colon_pos + 1;
+        char* token = strtok(neighbors_str, ", \n");
+
+        while (ok && token != NULL) {
+            int neighbor = atoi(token);
+            if (neighbor >= 0 && neighbor < num_vertices) {
+                if (count == capacity) {
+                    int* grown = realloc(neighbors, 2 * capacity * sizeof(int));
+                    if (grown == NULL) {
+                        ok = false;
+                        break;
+                    }
+                    neighbors = grown;
+                    capacity *= 2;
+                }
+                neighbors[count++] = neighbor;
+            }
+            token = strtok(NULL, ", \n");
+        }
+        if (!ok) break;
+    }
+
+    if (ok && count > 0) {
+        ok = set_compressed_neighbors(graph, pending_vertex, neighbors, count);
+    }
+    if (ok) {
+        ok = finish_compressed_graph(graph);
+    }
+
+    free(neighbors);
+    fclose(file);
+
+    if (!ok) {
+        printf("Error: failed to allocate memory for graph\n");
+        free_compressed_graph(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+/* Iterative so that long paths cannot overflow the call stack. Vertices are
+   marked when pushed, so graph->stack never holds more than num_vertices. */
+bool dfs_compressed(struct compressed_graph* graph, int current, int target) {
+    int* stack = graph->stack;
+    int top = 0;
+
+    graph->visited[current] = true;
+    STATS_ADD(vertices_visited, 1);
+    stack[top++] = current;
+    STATS_ENTER();
+
+    bool found = current == target;
+    while (!found && top > 0) {
+        int vertex = stack[--top];
+        STATS_LEAVE();
+
+        const unsigned char* p = graph->data + graph->offsets[vertex];
+        int adjacent_vertex = 0;
+        unsigned int gap;
+        for (int i = 0; i < graph->degrees[vertex]; i++) {
+            p = decode_varint(p, &gap);
+            adjacent_vertex += (int)gap;
+            STATS_ADD(edges_scanned, 1);
+            if (!graph->visited[adjacent_vertex]) {
+                graph->visited[adjacent_vertex] = true;
+                STATS_ADD(vertices_visited, 1);
+                if (adjacent_vertex == target) {
+                    found = true;
+                    break;
+                }
+                stack[top++] = adjacent_vertex;
+                STATS_ENTER();
+            }
+        }
+    }
+
+    while (top > 0) {
+        top--;
+        STATS_LEAVE();
+    }
+
+    return found;
+}
+
+bool path_exists_compressed(struct compressed_graph* graph, int start, int end) {
+    STATS_QUERY_BEGIN();
+
+    memset(graph->visited, 0, graph->num_vertices * sizeof(bool));
+
+    bool result = dfs_compressed(graph, start, end);
+
+    STATS_QUERY_END();
+
+    memset(graph->visited, 0, graph->num_vertices * sizeof(bool));
+
+    return result;
+}
+
+#define BATCH_IO_BUFFER_SIZE (1 << 16)
+#define DEFAULT_BATCH_SIZE 4096
+
+struct batch_report {
+    long long queries;
+    long long invalid;
+    double seconds;
+    double queries_per_second;
+};
+
+struct batch_query {
+    int start;
+    int end;
+    int index;
+};
+
+/* Traversal state kept across queries: a vertex counts as visited when its
+   stamp equals the current epoch, so no per-query clearing is needed, and the
+   explicit stack lets queries that share a start vertex resume one search. */
+struct batch_state {
+    int* visit_epoch;
+    int epoch;
+    int* stack;
+    int top;
+};
+
+struct query_reader {
+    FILE* file;
+    char* buffer;
+    size_t size;
+    size_t pos;
+    long long line;
+};
+
+struct result_writer {
+    FILE* file;
+    char* buffer;
+    size_t size;
+    bool failed;
+};
+
+static int reader_getc(struct query_reader* reader) {
+    if (reader->pos == reader->size) {
+        reader->size = fread(reader->buffer, 1, BATCH_IO_BUFFER_SIZE, reader->file);
+        reader->pos = 0;
+        if (reader->size == 0) return EOF;
+    }
+    return (unsigned char)reader->buffer[reader->pos++];
+}
+
+static int reader_skip_blanks(struct query_reader* reader, int c) {
+    while (c == ' ' || c == '\t' || c == '\r') c = reader_getc(reader);
+    return c;
+}
+
+/* Parses an optionally signed decimal with at least one digit, starting at *c. */
+static bool reader_parse_int(struct query_reader* reader, int* c, int* value) {
+    bool negative = *c == '-';
+    if (negative) *c = reader_getc(reader);
+    if (*c < '0' || *c > '9') return false;
+
+    long long result = 0;
+    while (*c >= '0' && *c <= '9') {
+        result = result * 10 + (*c - '0');
+        if (result > INT_MAX) return false;
+        *c = reader_getc(reader);
+    }
+
+    *value = negative ? -(int)result : (int)result;
+    return true;
+}
+
+/* Reads one "start end" or "start,end" line, skipping blank lines. Returns 1 for
+   a well-formed pair, 0 for a malformed line (consumed whole, so the following
+   lines stay aligned) and -1 at end of input. */
+static int reader_next_query(struct query_reader* reader, int* start, int* end) {
+    int c;
+    do {
+        c = reader_skip_blanks(reader, reader_getc(reader));
+        if (c == EOF) return -1;
+        reader->line++;
+    } while (c == '\n');
+
+    bool ok = reader_parse_int(reader, &c, start);
+    if (ok) {
+        c = reader_skip_blanks(reader, c);
+        if (c == ',') c = reader_skip_blanks(reader, reader_getc(reader));
+        ok = reader_parse_int(reader, &c, end);
+    }
+    if (ok) {
+        c = reader_skip_blanks(reader, c);
+        ok = c == '\n' || c == EOF;
+    }
+
+    while (c != '\n' && c != EOF) c = reader_getc(reader);
+    return ok ? 1 : 0;
+}
+
+static void writer_flush(struct result_writer* writer) {
+    if (writer->size > 0) {
+        if (fwrite(writer->buffer, 1, writer->size, writer->file) != writer->size) {
+            writer->failed = true;
+        }
+        writer->size = 0;
+    }
+}
+
+static void writer_put_int(struct result_writer* writer, int value) {
+    if (writer->size + 12 > BATCH_IO_BUFFER_SIZE) writer_flush(writer);
+
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0) writer->buffer[writer->size++] = '-';
+    while (count > 0) writer->buffer[writer->size++] = digits[--count];
+}
+
+static void writer_put_char(struct result_writer* writer, char c) {
+    if (writer->size == BATCH_IO_BUFFER_SIZE) writer_flush(writer);
+    writer->buffer[writer->size++] = c;
+}
+
+static void batch_begin_search(struct batch_state* state, int num_vertices, int start) {
+    if (state->epoch == INT_MAX) {
+        memset(state->visit_epoch, 0, num_vertices * sizeof(int));
+        state->epoch = 0;
+    }
+    state->epoch++;
+    state->visit_epoch[start] = state->epoch;
+    state->stack[0] = start;
+    state->top = 1;
+    STATS_ADD(vertices_visited, 1);
+}
+
+/* Continues the current search until target is reached or the stack runs dry. */
+static bool batch_resume_search(struct graph* graph, struct batch_state* state, int target) {
+    while (state->visit_epoch[target] != state->epoch && state->top > 0) {
+        int current = state->stack[--state->top];
+        for (struct node* temp = graph->adj_lists[current]; temp != NULL; temp = temp->next) {
+            STATS_ADD(edges_scanned, 1);
+            if (state->visit_epoch[temp->vertex] != state->epoch) {
+                state->visit_epoch[temp->vertex] = state->epoch;
+                state->stack[state->top++] = temp->vertex;
+                STATS_ADD(vertices_visited, 1);
+            }
+        }
+#if TRAVERSAL_STATS
+        if (state->top > g_traversal_stats.max_stack_depth) g_traversal_stats.max_stack_depth = state->top;
+#endif
+    }
+
+    return state->visit_epoch[target] == state->epoch;
+}
+
+static int compare_batch_queries(const void* a, const void* b) {
+    const struct batch_query* q1 = (const struct batch_query*)a;
+    const struct batch_query* q2 = (const struct batch_query*)b;
+    if (q1->start != q2->start) return (q1->start > q2->start) - (q1->start < q2->start);
+    return (q1->index > q2->index) - (q1->index < q2->index);
+}
+
+/* Reads one "start end" (or "start,end") pair per line from input until EOF and
+   writes one "start end result" line per query to output, in input order, where
+   result is 1 (path exists), 0 (no path) or -1 (vertex out of range). Malformed
+   lines are reported on stderr, counted as invalid and produce no result line.
+   Queries are answered batch_size at a time; within a batch, queries sharing a
+   start vertex share one search. Returns false on allocation or write failure. */
+bool run_batch_queries(struct graph* graph, FILE* input, FILE* output, int batch_size,
+    struct batch_report* report) {
+    if (graph == NULL || input == NULL || output == NULL) return false;
+    if (batch_size <= 0) batch_size = DEFAULT_BATCH_SIZE;
+
+    double started = monotonic_seconds();
+    int vertices = graph->num_vertices > 0 ? graph->num_vertices : 1;
+
+    struct batch_state state = { calloc(vertices, sizeof(int)), 0, malloc(vertices * sizeof(int)), 0 };
+    struct query_reader reader = { input, malloc(BATCH_IO_BUFFER_SIZE), 0, 0, 0 };
+    struct result_writer writer = { output, malloc(BATCH_IO_BUFFER_SIZE), 0, false };
+    struct batch_query* queries = malloc(batch_size * sizeof(struct batch_query));
+    struct batch_query* sorted = malloc(batch_size * sizeof(struct batch_query));
+    signed char* results = malloc(batch_size);
+
+    bool ok = state.visit_epoch != NULL && state.stack != NULL && reader.buffer != NULL &&
+        writer.buffer != NULL && queries != NULL && sorted != NULL && results != NULL;
+    if (!ok) {
+        fprintf(stderr, "Error: failed to allocate memory for batch queries\n");
+    }
+
+    long long total = 0;
+    long long invalid = 0;
+    bool done = false;
+    while (ok && !done && !writer.failed) {
+        int count = 0;
+        while (count < batch_size) {
+            int status = reader_next_query(&reader, &queries[count].start, &queries[count].end);
+            if (status < 0) {
+                done = true;
+                break;
+            }
+            if (status == 0) {
+                fprintf(stderr, "Error: malformed query on line %lld\n", reader.line);
+                total++;
+                invalid++;
+                continue;
+            }
+            queries[count].index = count;
+            count++;
+        }
+        if (count == 0) continue;
+
+        memcpy(sorted, queries, count * sizeof(struct batch_query));
+        qsort(sorted, count, sizeof(struct batch_query), compare_batch_queries);
+
+        int current_start = -1;
+        for (int i = 0; i < count; i++) {
+            struct batch_query* q = &sorted[i];
+            if (q->start < 0 || q->start >= graph->num_vertices ||
+                q->end < 0 || q->end >= graph->num_vertices) {
+                results[q->index] = -1;
+                invalid++;
+                continue;
+            }
+
+            if (q->start != current_start) {
+                batch_begin_search(&state, graph->num_vertices, q->start);
+                current_start = q->start;
+            }
+            results[q->index] = batch_resume_search(graph, &state, q->end) ? 1 : 0;
+        }
+
+        for (int i = 0; i < count; i++) {
+            writer_put_int(&writer, queries[i].start);
+            writer_put_char(&writer, ' ');
+            writer_put_int(&writer, queries[i].end);
+            writer_put_char(&writer, ' ');
+            writer_put_int(&writer, results[i]);
+            writer_put_char(&writer, '\n');
+        }
+
+        total += count;
+    }
+
+    if (writer.buffer != NULL) {
+        writer_flush(&writer);
+        if (fflush(output) != 0 || writer.failed || ferror(output)) {
+            fprintf(stderr, "Error: failed to write batch results\n");
+            ok = false;
+        }
+    }
+
+    double elapsed = monotonic_seconds() - started;
+#if TRAVERSAL_STATS
+    /* Only answered queries count, and the batch has no per-query timings, so
+       last_query_seconds becomes the run's mean time per answered query. */
+    long long answered = total - invalid;
+    if (answered > 0) {
+        g_traversal_stats.queries += answered;
+        g_traversal_stats.last_query_seconds = elapsed / answered;
+        g_traversal_stats.total_query_seconds += elapsed;
+    }
+#endif
+    if (report != NULL) {
+        report->queries = total;
+        report->invalid = invalid;
+        report->seconds = elapsed;
+        report->queries_per_second = elapsed > 0 ? total / elapsed : 0.0;
+    }
+
+    free(state.visit_epoch);
+    free(state.stack);
+    free(reader.buffer);
+    free(writer.buffer);
+    free(queries);
+    free(sorted);
+    free(results);
+    return ok;
+}
+
+/* Non-interactive counterpart of original_main. NULL or "-" selects stdin/stdout;
+   the throughput summary goes to stderr so it never mixes with the results. */
+int batch_main(const char* graph_filename, const char* query_filename, const char* output_filename) {
+    struct graph* graph = read_graph_from_file(graph_filename != NULL ? graph_filename : "text.txt");
+    if (graph == NULL) {
+        fprintf(stderr, "Failed to load graph from file\n");
+        return 1;
+    }
+
+    bool use_stdin = query_filename == NULL || strcmp(query_filename, "-") == 0;
+    bool use_stdout = output_filename == NULL || strcmp(output_filename, "-") == 0;
+    FILE* input = use_stdin ? stdin : fopen(query_filename, "rb");
+    FILE* output = use_stdout ? stdout : fopen(output_filename, "wb");
+
+    if (input == NULL || output == NULL) {
+        fprintf(stderr, "Error: cannot open %s\n", input == NULL ? query_filename : output_filename);
+        if (input != NULL && !use_stdin) fclose(input);
+        if (output != NULL && !use_stdout) fclose(output);
+        free_graph(graph);
+        return 1;
+    }
+
+    struct batch_report report;
+    bool ok = run_batch_queries(graph, input, output, DEFAULT_BATCH_SIZE, &report);
+    if (ok) {
+        fprintf(stderr, "Processed %lld queries (%lld invalid) in %.3f s: %.0f queries/s\n",
+            report.queries, report.invalid, report.seconds, report.queries_per_second);
+    }
+
+    if (!use_stdin) fclose(input);
+    if (!use_stdout) fclose(output);
+    free_graph(graph);
+    return ok ? 0 : 1;
+}
+
 int original_main() {
     struct graph* graph = read_graph_from_file("text.txt");
 
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <string>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -23,6 +24,49 @@ extern "C" {
     bool dfs(struct graph* graph, int current, int target);
     bool path_exists(struct graph* graph, int start, int end);
     void free_graph(struct graph* graph);
+
+    struct traversal_stats {
+        long long queries;
+        long long vertices_visited;
+        long long edges_scanned;
+        int max_stack_depth;
+        double last_query_seconds;
+        double total_query_seconds;
+    };
+
+    int traversal_stats_enabled(void);
+    void reset_traversal_stats(void);
+    void get_traversal_stats(struct traversal_stats* out);
+    void print_traversal_stats_json(FILE* out);
+
+    struct compressed_graph {
+        int num_vertices;
+        size_t* offsets;
+        int* degrees;
+        unsigned char* data;
+        size_t data_size;
+        size_t data_capacity;
+        bool* visited;
+        int* stack;
+    };
+
+    struct compressed_graph* create_compressed_graph(int vertices);
+    struct compressed_graph* compress_graph(struct graph* source);
+    struct compressed_graph* read_compressed_graph_from_file(const char* filename);
+    int get_compressed_neighbors(const struct compressed_graph* graph, int vertex, int* out);
+    bool dfs_compressed(struct compressed_graph* graph, int current, int target);
+    bool path_exists_compressed(struct compressed_graph* graph, int start, int end);
+    void free_compressed_graph(struct compressed_graph* graph);
+
+    struct batch_report {
+        long long queries;
+        long long invalid;
+        double seconds;
+        double queries_per_second;
+    };
+
+    bool run_batch_queries(struct graph* graph, FILE* input, FILE* output, int batch_size,
+        struct batch_report* report);
 }
 
 TEST(CreateNodeTest, CreatesNodeWithCorrectValues) {
@@ -147,6 +191,258 @@ TEST(FreeGraphTest, HandlesEmptyGraph) {
     free_graph(graph);
 }
 
+TEST(CompressGraphTest, StoresSortedNeighbors) {
+    struct graph* graph = create_graph(400);
+    add_edge(graph, 0, 300);
+    add_edge(graph, 0, 2);
+    add_edge(graph, 0, 150);
+    struct compressed_graph* compressed = compress_graph(graph);
+
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_EQ(compressed->degrees[0], 3);
+    EXPECT_EQ(compressed->degrees[1], 0);
+    EXPECT_EQ(compressed->data_size, 5u);
+    EXPECT_EQ(compressed->data_capacity, compressed->data_size);
+
+    int neighbors[3];
+    get_compressed_neighbors(compressed, 0, neighbors);
+    EXPECT_EQ(neighbors[0], 2);
+    EXPECT_EQ(neighbors[1], 150);
+    EXPECT_EQ(neighbors[2], 300);
+
+    free_compressed_graph(compressed);
+    free_graph(graph);
+}
+
+TEST(PathExistsCompressedTest, MatchesUncompressedGraph) {
+    struct graph* graph = create_graph(6);
+    add_edge(graph, 0, 1);
+    add_edge(graph, 1, 2);
+    add_edge(graph, 2, 3);
+    add_edge(graph, 4, 5);
+    struct compressed_graph* compressed = compress_graph(graph);
+    ASSERT_NE(compressed, nullptr);
+
+    for (int start = 0; start < 6; start++) {
+        for (int end = 0; end < 6; end++) {
+            EXPECT_EQ(path_exists_compressed(compressed, start, end), path_exists(graph, start, end));
+        }
+    }
+
+    free_compressed_graph(compressed);
+    free_graph(graph);
+}
+
+TEST(PathExistsCompressedTest, ResetsVisitedArray) {
+    struct compressed_graph* compressed = create_compressed_graph(3);
+    path_exists_compressed(compressed, 0, 2);
+    EXPECT_FALSE(compressed->visited[0]);
+    free_compressed_graph(compressed);
+}
+
+TEST(PathExistsCompressedTest, HandlesLongChain) {
+    const int n = 1000000;
+    struct graph* graph = create_graph(n);
+    for (int i = 0; i < n - 1; i++) {
+        add_edge(graph, i, i + 1);
+    }
+    struct compressed_graph* compressed = compress_graph(graph);
+    free_graph(graph);
+    ASSERT_NE(compressed, nullptr);
+
+    EXPECT_TRUE(path_exists_compressed(compressed, 0, n - 1));
+    EXPECT_FALSE(path_exists_compressed(compressed, n - 1, 0));
+    free_compressed_graph(compressed);
+}
+
+TEST(ReadCompressedGraphTest, ReadsAdjacencyFile) {
+    FILE* temp = fopen("compressed_test.txt", "w");
+    fprintf(temp, "4\n0:1\n1:2\n2:\n1:3\n");
+    fclose(temp);
+
+    struct compressed_graph* compressed = read_compressed_graph_from_file("compressed_test.txt");
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_EQ(compressed->degrees[1], 2);
+    EXPECT_EQ(compressed->data_size, 3u);
+    EXPECT_EQ(compressed->data_capacity, compressed->data_size);
+    EXPECT_TRUE(path_exists_compressed(compressed, 0, 3));
+    EXPECT_FALSE(path_exists_compressed(compressed, 3, 0));
+
+    free_compressed_graph(compressed);
+    remove("compressed_test.txt");
+}
+
+TEST(ReadCompressedGraphTest, MergesConsecutiveLinesOfOneVertex) {
+    FILE* temp = fopen("compressed_split_test.txt", "w");
+    fprintf(temp, "300\n0:");
+    for (int v = 1; v < 60; v++) fprintf(temp, "%d,", v);
+    fprintf(temp, "\n0:");
+    for (int v = 60; v < 110; v++) fprintf(temp, "%d,", v);
+    fprintf(temp, "\n1:0\n");
+    fclose(temp);
+
+    struct compressed_graph* compressed = read_compressed_graph_from_file("compressed_split_test.txt");
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_EQ(compressed->degrees[0], 109);
+    EXPECT_EQ(compressed->degrees[1], 1);
+    EXPECT_EQ(compressed->data_size, 110u);
+    EXPECT_EQ(compressed->data_capacity, compressed->data_size);
+    EXPECT_TRUE(path_exists_compressed(compressed, 1, 109));
+
+    free_compressed_graph(compressed);
+    remove("compressed_split_test.txt");
+}
+
+TEST(ReadCompressedGraphTest, ReturnsNullForNonExistentFile) {
+    EXPECT_EQ(read_compressed_graph_from_file("nonexistent_file.txt"), nullptr);
+}
+
+static std::string run_batch(struct graph* graph, const char* queries, int batch_size,
+    struct batch_report* report) {
+    FILE* input = tmpfile();
+    FILE* output = tmpfile();
+    fputs(queries, input);
+    rewind(input);
+
+    EXPECT_TRUE(run_batch_queries(graph, input, output, batch_size, report));
+
+    rewind(output);
+    std::string result;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), output) != NULL) result += buffer;
+
+    fclose(input);
+    fclose(output);
+    return result;
+}
+
+TEST(BatchQueriesTest, AnswersInInputOrder) {
+    struct graph* graph = create_graph(5);
+    add_edge(graph, 0, 1);
+    add_edge(graph, 1, 2);
+    add_edge(graph, 3, 4);
+
+    struct batch_report report;
+    std::string output = run_batch(graph, "0 2\n3 4\n0 4\n2 0\n0 0\n9 1\n", 4, &report);
+
+    EXPECT_EQ(output, "0 2 1\n3 4 1\n0 4 0\n2 0 0\n0 0 1\n9 1 -1\n");
+    EXPECT_EQ(report.queries, 6);
+    EXPECT_EQ(report.invalid, 1);
+    EXPECT_GE(report.queries_per_second, 0.0);
+    free_graph(graph);
+}
+
+TEST(BatchQueriesTest, MatchesPathExists) {
+    struct graph* graph = create_graph(6);
+    add_edge(graph, 0, 1);
+    add_edge(graph, 1, 2);
+    add_edge(graph, 2, 0);
+    add_edge(graph, 2, 3);
+    add_edge(graph, 4, 5);
+
+    std::string queries;
+    std::string expected;
+    for (int start = 0; start < 6; start++) {
+        for (int end = 5; end >= 0; end--) {
+            std::string pair = std::to_string(start) + " " + std::to_string(end);
+            queries += pair + "\n";
+            expected += pair + (path_exists(graph, start, end) ? " 1\n" : " 0\n");
+        }
+    }
+
+    EXPECT_EQ(run_batch(graph, queries.c_str(), 5, nullptr), expected);
+    free_graph(graph);
+}
+
+TEST(BatchQueriesTest, AcceptsCommaSeparatedPairs) {
+    struct graph* graph = create_graph(2);
+    add_edge(graph, 0, 1);
+    EXPECT_EQ(run_batch(graph, "0,1\n\n 1 , 0 \r\n", 0, nullptr), "0 1 1\n1 0 0\n");
+    free_graph(graph);
+}
+
+TEST(BatchQueriesTest, ReportsMalformedLines) {
+    struct graph* graph = create_graph(6);
+    add_edge(graph, 0, 1);
+
+    struct batch_report report;
+    std::string output = run_batch(graph, "0 -\n1 - 2\n5\n0 1\nabc\n1 2 3\n0 99999999999\n1 0", 2, &report);
+
+    EXPECT_EQ(output, "0 1 1\n1 0 0\n");
+    EXPECT_EQ(report.queries, 8);
+    EXPECT_EQ(report.invalid, 6);
+    free_graph(graph);
+}
+
+TEST(BatchQueriesTest, StatsCountOnlyAnsweredQueries) {
+    if (!traversal_stats_enabled()) GTEST_SKIP();
+    struct graph* graph = create_graph(3);
+    add_edge(graph, 0, 1);
+
+    reset_traversal_stats();
+    run_batch(graph, "0 1\n0 2\nbad\n7 0\n", 0, nullptr);
+
+    struct traversal_stats stats;
+    get_traversal_stats(&stats);
+    EXPECT_EQ(stats.queries, 2);
+    EXPECT_GE(stats.total_query_seconds, 0.0);
+    EXPECT_GE(stats.last_query_seconds, 0.0);
+    free_graph(graph);
+}
+
+TEST(BatchQueriesTest, FailsOnWriteError) {
+    FILE* temp = fopen("batch_readonly.txt", "w");
+    fclose(temp);
+
+    struct graph* graph = create_graph(2);
+    FILE* input = tmpfile();
+    fputs("0 1\n", input);
+    rewind(input);
+    FILE* output = fopen("batch_readonly.txt", "r");
+
+    EXPECT_FALSE(run_batch_queries(graph, input, output, 0, nullptr));
+
+    fclose(input);
+    fclose(output);
+    free_graph(graph);
+    remove("batch_readonly.txt");
+}
+
+TEST(BatchQueriesTest, EmptyInput) {
+    struct graph* graph = create_graph(2);
+    struct batch_report report;
+    EXPECT_EQ(run_batch(graph, "", 0, &report), "");
+    EXPECT_EQ(report.queries, 0);
+    free_graph(graph);
+}
+
+TEST(TraversalStatsTest, CountsChainTraversal) {
+    if (!traversal_stats_enabled()) GTEST_SKIP();
+    struct graph* graph = create_graph(4);
+    add_edge(graph, 0, 1);
+    add_edge(graph, 1, 2);
+    add_edge(graph, 2, 3);
+
+    reset_traversal_stats();
+    EXPECT_TRUE(path_exists(graph, 0, 3));
+
+    struct traversal_stats stats;
+    get_traversal_stats(&stats);
+    EXPECT_EQ(stats.queries, 1);
+    EXPECT_EQ(stats.vertices_visited, 4);
+    EXPECT_EQ(stats.edges_scanned, 3);
+    EXPECT_EQ(stats.max_stack_depth, 4);
+    free_graph(graph);
+}
+
+TEST(TraversalStatsTest, PrintsJson) {
+    reset_traversal_stats();
+    testing::internal::CaptureStdout();
+    print_traversal_stats_json(stdout);
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_TRUE(output.find("\"queries\": 0") != std::string::npos);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();